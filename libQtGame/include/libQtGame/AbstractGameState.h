@@ -1,7 +1,14 @@
 #pragma once
 
+#include <QDataStream>
 #include <QObject>
 
+#include <libQtGame/InputEventQueue.h>
+#include <libQtGame/StateFactory.h>
+
+#include <functional>
+#include <memory>
+
 #include <utilsLib/Utils.h>
 
 #include <QtUtilsLib/Multithreading.h>
@@ -30,7 +37,8 @@ public:
     ExitAll
   };
 
-  using SimulationData = osgHelper::SimulationCallback::SimulationData;
+  using SimulationData    = osgHelper::SimulationCallback::SimulationData;
+  using RequestDispatcher = std::function<void(const std::function<void()>&)>;
 
   explicit AbstractGameState(osgHelper::ioc::Injector& injector);
   ~AbstractGameState() override;
@@ -38,6 +46,15 @@ public:
   virtual void onInitialize(const SimulationData& data);
   virtual void onUpdate(const SimulationData& data);
   virtual void onExit();
+  // Buffered input (see KeyboardMouseEventFilter::setInputEventQueue()), called in the simulation thread.
+  // Events are passed from the top of the state stack downwards, returning true stops them from being
+  // passed on to the states below.
+  virtual bool onInputEvent(const InputEvent& event);
+
+  // State stack snapshots (see GameStatesApplication::snapshotStates()).
+  // Called before onInitialize() when a state is restored.
+  virtual void serialize(QDataStream& stream) const;
+  virtual void deserialize(QDataStream& stream);
 
   template <typename TState>
   void requestNewEventState(NewGameStateMode mode = NewGameStateMode::ContinueCurrent)
@@ -47,9 +64,9 @@ public:
       m_isExiting = true;
     }
 
-    QtUtilsLib::Multithreading::executeInUiAsync([this, mode]()
+    dispatchRequest([this, mode]()
     {
-      const auto state = m_injector->inject<TState>();
+      const auto state = createState<TState>(*m_injector, m_stateFactoryCache.get());
       assert_return(state.valid());
 
       Q_EMIT forwardNewEventStateRequest(this, mode, state);
@@ -61,6 +78,10 @@ public:
 
   bool isExiting() const;
 
+  // Requests are executed asynchronously in the UI thread unless a dispatcher is set
+  void setRequestDispatcher(RequestDispatcher dispatcher);
+  void setStateFactoryCache(const std::shared_ptr<StateFactoryCache>& cache);
+
 Q_SIGNALS:
   void forwardNewEventStateRequest(const osg::ref_ptr<AbstractGameState>& current, NewGameStateMode mode,
                                    const osg::ref_ptr<AbstractGameState>& newState);
@@ -71,6 +92,10 @@ Q_SIGNALS:
 private:
   osgHelper::ioc::Injector* m_injector;
   bool m_isExiting;
+  RequestDispatcher m_requestDispatcher;
+  std::shared_ptr<StateFactoryCache> m_stateFactoryCache;
+
+  void dispatchRequest(const std::function<void()>& request);
 
 };
 
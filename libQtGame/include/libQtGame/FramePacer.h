@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QMutex>
+
+#include <chrono>
+
+namespace libQtGame
+{
+
+/**
+ * Limits the frame rate to a target rate. Waits by sleeping until shortly before the deadline
+ * and spinning for the remainder, and keeps frame time, jitter and overrun statistics.
+ */
+class FramePacer
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Statistics
+  {
+    unsigned long long numFrames = 0;
+    unsigned long long numLimitedFrames = 0; // frames paced with a target rate
+    unsigned long long numOverruns = 0;      // frames whose wait began after their deadline (plus tolerance)
+    unsigned long long numReschedules = 0;   // overruns of more than one period, the schedule restarts instead of catching up
+    double lastFrameTime = 0.0;              // seconds between the last two frames
+    double meanFrameTime = 0.0;
+    double frameTimeStdDev = 0.0;
+    double meanJitter = 0.0;                 // mean absolute deviation of limited frame starts from their deadlines in seconds
+    double maxJitter = 0.0;
+  };
+
+  FramePacer();
+  ~FramePacer();
+
+  // 0 disables the limit, statistics are still collected
+  void setTargetRate(double framesPerSecond);
+  double targetRate() const;
+
+  // Remaining time before a deadline that is spent spinning instead of sleeping
+  void setSpinThreshold(Clock::duration threshold);
+
+  // Lateness of the wait beginning tolerated before a frame counts as overrun
+  void setOverrunTolerance(Clock::duration tolerance);
+
+  // Blocks until the next frame is due
+  void waitForNextFrame();
+
+  Statistics statistics() const;
+  void resetStatistics();
+
+private:
+  mutable QMutex m_mutex;
+
+  double          m_targetRate;
+  Clock::duration m_period;
+  Clock::duration m_spinThreshold;
+  Clock::duration m_overrunTolerance;
+
+  Clock::time_point m_deadline;
+  unsigned int      m_scheduleGeneration; // incremented whenever setTargetRate() restarts the schedule
+  Clock::time_point m_lastFrameStart;
+  bool              m_hasLastFrame;
+
+  Statistics m_statistics;
+  double     m_frameTimeM2;
+  double     m_jitterSum;
+
+  void updateStatistics(const Clock::time_point& waitBegin, const Clock::time_point& frameStart,
+                        const Clock::time_point& deadline, bool limited);
+
+};
+
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <libQtGame/AbstractGameState.h>
+#include <libQtGame/InputEventQueue.h>
+#include <libQtGame/StateFactory.h>
+
+#include <QByteArray>
+#include <QMetaObject>
+#include <QRecursiveMutex>
+
+#include <osgHelper/ioc/Injector.h>
+#include <osgHelper/SimulationCallback.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <vector>
+
+namespace libQtGame
+{
+
+class GameStatesObject;
+
+class GameStateMachine
+{
+public:
+  using SimulationData = osgHelper::SimulationCallback::SimulationData;
+
+  enum class RequestDispatchMode
+  {
+    UiThread, // state requests are executed asynchronously in the UI thread
+    Deferred  // state requests are queued and executed by the next update() on the calling thread
+  };
+
+  struct Callbacks
+  {
+    std::function<void(const osg::ref_ptr<AbstractGameState>&, const SimulationData&)> onPrepareGameState;
+    std::function<void(const osg::ref_ptr<AbstractGameState>&)> onExitGameState;
+    std::function<void()> onEmptyStateList;
+    std::function<void(const SimulationData&)> onPreStatesUpdate;
+    std::function<void()> onResetTimeDelta;
+  };
+
+  struct RestoreResult
+  {
+    bool success = false;
+    int numStates = 0;
+    qint64 elapsedNs = 0;
+  };
+
+  explicit GameStateMachine(RequestDispatchMode mode = RequestDispatchMode::UiThread, Callbacks callbacks = {});
+  ~GameStateMachine();
+
+  void update(const SimulationData& data);
+  void pushAndPrepareState(const osg::ref_ptr<AbstractGameState>& state);
+  void exitState(const osg::ref_ptr<AbstractGameState>& state);
+  // Calls onExit() on all states, clears the stack without invoking any callbacks
+  // and releases the dependencies cached by the state factories
+  void shutdown();
+
+  // Input events of the queue are dispatched to the states from the top of the stack downwards
+  // at the beginning of each update()
+  void setInputEventQueue(const std::shared_ptr<InputEventQueue>& queue);
+
+  // See StateFactoryCache::setInjectionMutex()
+  void setInjectionMutex(const std::shared_ptr<std::recursive_mutex>& mutex);
+
+  bool isEmpty() const;
+  size_t numStates() const;
+
+  template <typename TState>
+  bool injectPushAndPrepareState(osgHelper::ioc::Injector& injector)
+  {
+    QMutexLocker locker(&m_statesMutex);
+
+    auto state = createState<TState>(injector, m_stateFactoryCache.get());
+    assert_return(state.valid(), false);
+
+    pushAndPrepareState(state);
+
+    return true;
+  }
+
+  // Serializes the whole state stack into a compact binary blob, skipping exiting states.
+  // Returns an empty blob if a state on the stack is not registered via registerSnapshotStateType().
+  QByteArray snapshotStates() const;
+  // Replaces the current state stack by the given snapshot in one pass.
+  RestoreResult restoreStates(const QByteArray& snapshot);
+
+  // States are identified by their Qt class name, so they need the Q_OBJECT macro
+  template <typename TState>
+  void registerSnapshotStateType(osgHelper::ioc::Injector& injector)
+  {
+    static_assert(QtPrivate::HasQ_OBJECT_Macro<TState>::Value,
+      "Snapshot state types need the Q_OBJECT macro, otherwise they are identified by their base class name");
+
+    m_snapshotStateFactories.insert_or_assign(TState::staticMetaObject.className(), SnapshotStateFactory{
+      std::type_index(typeid(TState)),
+      [this, &injector]()
+      {
+        return osg::ref_ptr<AbstractGameState>(createState<TState>(injector, m_stateFactoryCache.get()));
+      }
+    });
+  }
+
+private:
+  struct StateData
+  {
+    osg::ref_ptr<AbstractGameState> state;
+    std::vector<QMetaObject::Connection> connections;
+  };
+
+  struct SnapshotStateFactory
+  {
+    std::type_index type;
+    std::function<osg::ref_ptr<AbstractGameState>()> create;
+  };
+
+  using StateList            = std::vector<StateData>;
+  using Request              = std::pair<AbstractGameState*, std::function<void()>>;
+
+  RequestDispatchMode m_mode;
+  Callbacks           m_callbacks;
+
+  mutable QRecursiveMutex m_statesMutex;
+  StateList               m_states;
+
+  SimulationData m_simData;
+
+  std::shared_ptr<InputEventQueue> m_inputEventQueue;
+
+  std::mutex           m_pendingRequestsMutex;
+  std::vector<Request> m_pendingRequests;
+  std::vector<Request> m_executingRequests;
+
+  std::map<std::string, SnapshotStateFactory> m_snapshotStateFactories;
+  std::shared_ptr<StateFactoryCache>          m_stateFactoryCache;
+
+  std::unique_ptr<GameStatesObject> m_obj;
+
+  void prepareGameState(StateData& data);
+  void executePendingRequests();
+  void removePendingRequests(AbstractGameState* state);
+  void dispatchInputEvents();
+
+  void onNewGameStateRequest(
+    const osg::ref_ptr<AbstractGameState>& current,
+    AbstractGameState::NewGameStateMode mode,
+    const osg::ref_ptr<AbstractGameState>& newState);
+  void onExitGameStateRequest(
+    const osg::ref_ptr<AbstractGameState>& current,
+    AbstractGameState::ExitGameStateMode mode);
+
+  friend class GameStatesObject;
+
+};
+
+}
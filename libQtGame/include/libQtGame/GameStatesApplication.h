@@ -1,10 +1,10 @@
 #pragma once
 
 #include <libQtGame/AbstractGameState.h>
+#include <libQtGame/GameStateMachine.h>
 #include <libQtGame/GameUpdateCallback.h>
 
-#include <QMetaObject>
-#include <QRecursiveMutex>
+#include <QByteArray>
 
 #include <QtUtilsLib/QtUtilsApplication.h>
 
@@ -12,30 +12,25 @@
 #include <osgHelper/ioc/InjectionContainer.h>
 #include <osgHelper/SimulationCallback.h>
 
-#include <memory>
-
 namespace libQtGame
 {
 
-class GameStatesObject;
-
 class GameStatesApplication : public QtUtilsLib::QtUtilsApplication<osg::ref_ptr<osg::Referenced>>,
                               public osgHelper::GameApplication
 {
 public:
+  using RestoreResult = GameStateMachine::RestoreResult;
+
   GameStatesApplication();
   ~GameStatesApplication();
 
-protected:
-  struct StateData
-  {
-    osg::ref_ptr<AbstractGameState> state;
-    std::vector<QMetaObject::Connection> connections;
-  };
+  // See GameStateMachine::snapshotStates() and GameStateMachine::restoreStates()
+  QByteArray snapshotStates();
+  RestoreResult restoreStates(const QByteArray& snapshot);
 
+protected:
   int runGame();
 
-  void prepareGameState(StateData& data);
   void onException(const std::string& message) override;
 
   virtual void registerEssentialComponents(osgHelper::ioc::InjectionContainer& container);
@@ -49,44 +44,28 @@ protected:
   virtual void onShutdown() = 0;
   virtual void onPreStatesUpdate(const osgHelper::SimulationCallback::SimulationData& data);
 
+  // Enables buffered input: set the same queue on the KeyboardMouseEventFilter
+  void setInputEventQueue(const std::shared_ptr<InputEventQueue>& queue);
+
   template <typename TState>
   bool injectPushAndPrepareState()
   {
-    QMutexLocker locker(&m_statesMutex);
-
-    auto state = injector().inject<TState>();
-    assert_return(state.valid(), false);
-
-    pushAndPrepareState(state);
+    return m_stateMachine.injectPushAndPrepareState<TState>(injector());
+  }
 
-    return true;
+  // See GameStateMachine::registerSnapshotStateType()
+  template <typename TState>
+  void registerSnapshotStateType()
+  {
+    m_stateMachine.registerSnapshotStateType<TState>(injector());
   }
 
 private:
-  QRecursiveMutex m_statesMutex;
-
-  using StateList = std::vector<StateData>;
-  StateList m_states;
-
-  AbstractGameState::SimulationData m_simData;
+  GameStateMachine m_stateMachine;
 
   osg::ref_ptr<libQtGame::GameUpdateCallback> m_updateCallback;
 
-  std::unique_ptr<GameStatesObject> m_obj;
-
   void updateStates(const osgHelper::SimulationCallback::SimulationData& data);
-  void pushAndPrepareState(const osg::ref_ptr<AbstractGameState>& state);
-  void exitState(const osg::ref_ptr<AbstractGameState>& state);
-
-  void onNewGameStateRequest(
-    const osg::ref_ptr<AbstractGameState>& current,
-    AbstractGameState::NewGameStateMode mode,
-    const osg::ref_ptr<AbstractGameState>& newState);
-  void onExitGameStateRequest(
-    const osg::ref_ptr<AbstractGameState>& current,
-    AbstractGameState::ExitGameStateMode mode);
-
-  friend class GameStatesObject;
 
 };
 
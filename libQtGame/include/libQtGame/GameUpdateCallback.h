@@ -1,5 +1,7 @@
 #pragma once
 
+#include <libQtGame/FramePacer.h>
+
 #include <functional>
 
 #include <osgHelper/SimulationCallback.h>
@@ -13,11 +15,18 @@ namespace libQtGame
 
     GameUpdateCallback(UpdateFunc func);
 
+    // Paces the update rate, uncapped by default. The wait happens before the simulation time is sampled,
+    // so update, cull and draw follow right after the deadline. It blocks the thread driving the viewer.
+    FramePacer& framePacer();
+
+    void operator()(osg::Node* node, osg::NodeVisitor* nv) override;
+
 	protected:
     void action(const SimulationData& data) override;
 
   private:
     UpdateFunc m_func;
+    FramePacer m_framePacer;
 
   };
 }
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <libQtGame/GameStateMachine.h>
+
+#include <QThreadPool>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace libQtGame
+{
+
+/**
+ * Drives any number of independent GameStateMachines concurrently on a thread pool,
+ * without a GameStatesApplication, a viewer or a UI thread. Each machine has its own time source.
+ *
+ * The machines typically share one injector, which is not thread-safe. The runner therefore
+ * serializes state creation of all its machines through a shared injection mutex. States must not
+ * use the injector anywhere else (e.g. in onUpdate()) while the runner is stepping.
+ */
+class HeadlessGameStatesRunner
+{
+public:
+  // Returns the current simulation time in seconds
+  using TimeSource = std::function<double()>;
+
+  explicit HeadlessGameStatesRunner(int maxThreadCount = QThread::idealThreadCount());
+  ~HeadlessGameStatesRunner();
+
+  static TimeSource makeFixedStepTimeSource(double stepSeconds);
+  static TimeSource makeRealTimeSource();
+
+  GameStateMachine& addMachine(TimeSource timeSource = makeFixedStepTimeSource(1.0 / 60.0),
+                               GameStateMachine::Callbacks callbacks = {});
+
+  size_t numMachines() const;
+  GameStateMachine& machine(size_t index);
+
+  // Updates every machine once and blocks until all of them are done
+  void step();
+  void run(int numSteps);
+
+  // Calls shutdown() on every machine
+  void shutdown();
+
+private:
+  struct MachineData
+  {
+    std::unique_ptr<GameStateMachine> machine;
+    TimeSource timeSource;
+    double lastTime = 0.0;
+    bool hasLastTime = false;
+    std::atomic<bool> resetTimeDelta { false };
+  };
+
+  QThreadPool m_threadPool;
+  std::shared_ptr<std::recursive_mutex> m_injectionMutex;
+  std::vector<std::unique_ptr<MachineData>> m_machines;
+
+  static void stepMachine(MachineData& data);
+
+};
+
+}
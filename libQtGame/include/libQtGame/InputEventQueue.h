@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QMutex>
+#include <Qt>
+
+#include <osg/Vec2f>
+
+#include <type_traits>
+#include <vector>
+
+namespace libQtGame
+{
+
+struct InputEvent
+{
+  enum class Type : quint8
+  {
+    KeyPress,
+    KeyRelease,
+    Wheel
+  };
+
+  Type                  type;
+  Qt::KeyboardModifiers modifiers;
+  int                   key;         // Qt::Key, only for key events
+  int                   wheelDeltaX; // angle delta in eighths of a degree, only for wheel events
+  int                   wheelDeltaY;
+  osg::Vec2f            position;    // only for wheel events
+};
+
+static_assert(std::is_trivially_copyable<InputEvent>::value, "InputEvent must be trivially copyable");
+
+/**
+ * Double buffered, preallocated per-frame queue of input events. The UI thread pushes events,
+ * the simulation thread takes all events of the frame at once via acquireFrame().
+ */
+class InputEventQueue
+{
+public:
+  explicit InputEventQueue(size_t capacity = 256);
+  ~InputEventQueue();
+
+  // Returns false and drops the event if the current frame is full
+  bool push(const InputEvent& event);
+
+  // Returns the events pushed since the last call. The result is valid until the next call.
+  // Must only be called from a single consumer thread.
+  const std::vector<InputEvent>& acquireFrame();
+
+  size_t capacity() const;
+  size_t numDropped() const;
+
+private:
+  mutable QMutex m_mutex;
+
+  size_t m_capacity;
+  size_t m_numDropped;
+
+  std::vector<InputEvent> m_pending;
+  std::vector<InputEvent> m_frame;
+
+};
+
+}
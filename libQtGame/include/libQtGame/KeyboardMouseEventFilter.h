@@ -1,5 +1,7 @@
 #pragma once
 
+#include <libQtGame/InputEventQueue.h>
+
 #include <QKeyEvent>
 #include <QObject>
 #include <QRecursiveMutex>
@@ -7,6 +9,7 @@
 #include <osg/Vec2f>
 
 #include <map>
+#include <memory>
 #include <optional>
 
 namespace libQtGame
@@ -17,6 +20,12 @@ class KeyboardMouseEventFilter : public QObject
   Q_OBJECT
 
 public:
+  enum class MouseCaptureMode
+  {
+    Warp,    // the cursor is reset to the capture position on every mouse move
+    Relative // mouse moves are accumulated, the cursor is only re-centered when it approaches the window edge
+  };
+
   explicit KeyboardMouseEventFilter(QObject* parent = nullptr);
   ~KeyboardMouseEventFilter() override;
 
@@ -24,7 +33,13 @@ public:
   bool isMouseButtonDown(Qt::MouseButton button) const;
   bool isMouseDragging(const std::optional<Qt::MouseButton>& button = std::nullopt) const;
 
-  void setCaptureMouse(bool on);
+  void setCaptureMouse(bool on, MouseCaptureMode mode = MouseCaptureMode::Warp);
+  // Distance to the window edge in pixels at which the cursor is re-centered in relative capture mode
+  void setRelativeCaptureMargin(int margin);
+
+  // Buffered mode: key and wheel events are pushed into the queue instead of emitting
+  // triggerKeyEvent() and triggerWheelEvent(), and are passed on unaccepted. Pass nullptr to disable.
+  void setInputEventQueue(const std::shared_ptr<InputEventQueue>& queue);
 
 Q_SIGNALS:
   void triggerKeyEvent(QKeyEvent* event, bool& accepted);
@@ -64,16 +79,25 @@ private:
   std::map<Qt::MouseButton, bool> m_isMouseDown;
   std::map<Qt::Key, bool>         m_isKeyDown;
 
+  std::shared_ptr<InputEventQueue> m_inputEventQueue;
+
   bool m_isMouseCaptured;
+  MouseCaptureMode m_mouseCaptureMode;
   QPoint m_capturedMousePos;
+  QPoint m_lastGlobalMousePos;
+  int m_relativeCaptureMargin;
+  std::optional<QPoint> m_recenterMousePos;
 
   void setMouseDown(Qt::MouseButton button, bool down);
   void setKeyDown(Qt::Key key, bool down);
 
-  bool handleMouseEvent(QMouseEvent* mouseEvent);
+  std::shared_ptr<InputEventQueue> inputEventQueue() const;
+
+  bool handleMouseEvent(QObject* object, QMouseEvent* mouseEvent);
+  bool isRecenterMouseMove(QMouseEvent* mouseEvent);
   void handleMouseButtonPress(QMouseEvent* mouseEvent);
   std::optional<MouseDragData> handleMouseButtonRelease(QMouseEvent* mouseEvent);
-  void handleMouseCapture(QMouseEvent* mouseEvent);
+  void handleMouseCapture(QObject* object, QMouseEvent* mouseEvent);
   MouseDragMoveData handleMouseDragMove(QMouseEvent* mouseEvent);
 
 };
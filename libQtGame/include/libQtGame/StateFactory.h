@@ -0,0 +1,130 @@
+#pragma once
+
+#include <osg/ref_ptr>
+
+#include <osgHelper/ioc/Injector.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <typeindex>
+
+namespace libQtGame
+{
+
+/**
+ * Holds the dependencies resolved by CachedStateFactory. It is owned by a GameStateMachine and shared
+ * with its states, so cached dependencies are released together with the machine (or on shutdown())
+ * instead of during static destruction. All states of a machine must use the same injector.
+ */
+class StateFactoryCache
+{
+public:
+  StateFactoryCache();
+  ~StateFactoryCache();
+
+  template <typename TState, typename... TDeps>
+  std::tuple<osg::ref_ptr<TDeps>...> dependencies(osgHelper::ioc::Injector& injector)
+  {
+    using Dependencies = std::tuple<osg::ref_ptr<TDeps>...>;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto& entry = m_entries[std::type_index(typeid(TState))];
+    if (!entry)
+    {
+      entry = std::make_shared<Dependencies>(injector.inject<TDeps>()...);
+    }
+
+    return *std::static_pointer_cast<Dependencies>(entry);
+  }
+
+  void clear();
+
+  // Serializes state creation (and thus injection) across all caches sharing the mutex,
+  // needed when machines on different threads share an injector
+  void setInjectionMutex(const std::shared_ptr<std::recursive_mutex>& mutex);
+  std::recursive_mutex* injectionMutex() const;
+
+private:
+  std::mutex m_mutex;
+  std::shared_ptr<std::recursive_mutex> m_injectionMutex;
+  std::map<std::type_index, std::shared_ptr<void>> m_entries;
+
+};
+
+/**
+ * Compile-time state factory. Not registered by default, so state creation falls back to
+ * Injector::inject<TState>(). Specialize it for a state type (or use LIBQTGAME_REGISTER_STATE_FACTORY)
+ * to bypass the runtime container lookup on every state transition.
+ *
+ * The specialization must be visible wherever createState<TState>() is instantiated, e.g. by
+ * requestNewEventState<TState>(), so put it into the state's own header. Otherwise translation
+ * units disagree about isRegistered, which violates the one definition rule.
+ *
+ * A registered specialization provides:
+ *   static constexpr bool isRegistered = true;
+ *   static osg::ref_ptr<TState> create(osgHelper::ioc::Injector& injector, StateFactoryCache* cache);
+ */
+template <typename TState>
+struct StateFactory
+{
+  static constexpr bool isRegistered = false;
+};
+
+/**
+ * Factory base resolving the dependencies TDeps once per StateFactoryCache. Afterwards creating a state
+ * only costs its constructor TState(Injector&, osg::ref_ptr<TDeps>...).
+ * Only singleton dependencies are valid, since all instances of the state share the cached ones.
+ */
+template <typename TState, typename... TDeps>
+struct CachedStateFactory
+{
+  static constexpr bool isRegistered = true;
+
+  static osg::ref_ptr<TState> create(osgHelper::ioc::Injector& injector, StateFactoryCache* cache)
+  {
+    const auto dependencies = cache
+      ? cache->dependencies<TState, TDeps...>(injector)
+      : std::make_tuple(injector.inject<TDeps>()...);
+
+    return std::apply([&injector](const osg::ref_ptr<TDeps>&... deps)
+    {
+      return osg::ref_ptr<TState>(new TState(injector, deps...));
+    }, dependencies);
+  }
+};
+
+template <typename TState>
+osg::ref_ptr<TState> createState(osgHelper::ioc::Injector& injector, StateFactoryCache* cache = nullptr)
+{
+  std::unique_lock<std::recursive_mutex> lock;
+  if (cache && cache->injectionMutex())
+  {
+    lock = std::unique_lock<std::recursive_mutex>(*cache->injectionMutex());
+  }
+
+  if constexpr (StateFactory<TState>::isRegistered)
+  {
+    return StateFactory<TState>::create(injector, cache);
+  }
+  else
+  {
+    return injector.inject<TState>();
+  }
+}
+
+}
+
+/**
+ * Registers a CachedStateFactory for the given state type. Must be used at global namespace scope,
+ * preferably in the state's header (see StateFactory).
+ * Example: LIBQTGAME_REGISTER_STATE_FACTORY(MyState, IResourceManager, IShaderFactory)
+ */
+#define LIBQTGAME_REGISTER_STATE_FACTORY(TState, ...) \
+  template <> \
+  struct libQtGame::StateFactory<TState> : libQtGame::CachedStateFactory<TState, ##__VA_ARGS__> \
+  { \
+  };
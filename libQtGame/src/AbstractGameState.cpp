@@ -27,10 +27,23 @@ void AbstractGameState::onExit()
 {
 }
 
+bool AbstractGameState::onInputEvent(const InputEvent& event)
+{
+  return false;
+}
+
+void AbstractGameState::serialize(QDataStream& stream) const
+{
+}
+
+void AbstractGameState::deserialize(QDataStream& stream)
+{
+}
+
 void AbstractGameState::requestExitEventState(ExitGameStateMode mode)
 {
   m_isExiting = true;
-  QtUtilsLib::Multithreading::executeInUiAsync([this, mode]()
+  dispatchRequest([this, mode]()
   {
     Q_EMIT forwardExitEventStateRequest(this, mode);
   });
@@ -38,7 +51,7 @@ void AbstractGameState::requestExitEventState(ExitGameStateMode mode)
 
 void AbstractGameState::requestResetTimeDelta()
 {
-  QtUtilsLib::Multithreading::executeInUiAsync([this]()
+  dispatchRequest([this]()
   {
     Q_EMIT forwardResetTimeDeltaRequest();
   });
@@ -49,4 +62,25 @@ bool AbstractGameState::isExiting() const
   return m_isExiting;
 }
 
+void AbstractGameState::setRequestDispatcher(RequestDispatcher dispatcher)
+{
+  m_requestDispatcher = std::move(dispatcher);
+}
+
+void AbstractGameState::setStateFactoryCache(const std::shared_ptr<StateFactoryCache>& cache)
+{
+  m_stateFactoryCache = cache;
+}
+
+void AbstractGameState::dispatchRequest(const std::function<void()>& request)
+{
+  if (m_requestDispatcher)
+  {
+    m_requestDispatcher(request);
+    return;
+  }
+
+  QtUtilsLib::Multithreading::executeInUiAsync(request);
+}
+
 }
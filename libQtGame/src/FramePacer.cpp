@@ -0,0 +1,158 @@
+#include <libQtGame/FramePacer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace libQtGame
+{
+
+FramePacer::FramePacer() :
+  m_targetRate(0.0),
+  m_period(Clock::duration::zero()),
+  m_spinThreshold(std::chrono::milliseconds(2)),
+  m_overrunTolerance(std::chrono::microseconds(500)),
+  m_scheduleGeneration(0),
+  m_hasLastFrame(false),
+  m_frameTimeM2(0.0),
+  m_jitterSum(0.0)
+{
+}
+
+FramePacer::~FramePacer() = default;
+
+void FramePacer::setTargetRate(double framesPerSecond)
+{
+  QMutexLocker locker(&m_mutex);
+
+  m_targetRate = std::max(0.0, framesPerSecond);
+  m_period     = (m_targetRate > 0.0)
+    ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_targetRate))
+    : Clock::duration::zero();
+  m_deadline   = Clock::now() + m_period;
+  m_scheduleGeneration++;
+}
+
+double FramePacer::targetRate() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_targetRate;
+}
+
+void FramePacer::setSpinThreshold(Clock::duration threshold)
+{
+  QMutexLocker locker(&m_mutex);
+  m_spinThreshold = threshold;
+}
+
+void FramePacer::setOverrunTolerance(Clock::duration tolerance)
+{
+  QMutexLocker locker(&m_mutex);
+  m_overrunTolerance = tolerance;
+}
+
+void FramePacer::waitForNextFrame()
+{
+  const auto waitBegin = Clock::now();
+
+  Clock::duration   period;
+  Clock::duration   spinThreshold;
+  Clock::time_point deadline;
+  unsigned int      generation;
+  {
+    QMutexLocker locker(&m_mutex);
+    period        = m_period;
+    spinThreshold = m_spinThreshold;
+    deadline      = m_deadline;
+    generation    = m_scheduleGeneration;
+  }
+
+  const auto limited = (period > Clock::duration::zero());
+  if (limited)
+  {
+    if (waitBegin + spinThreshold < deadline)
+    {
+      std::this_thread::sleep_until(deadline - spinThreshold);
+    }
+
+    while (Clock::now() < deadline)
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  const auto frameStart = Clock::now();
+
+  QMutexLocker locker(&m_mutex);
+  updateStatistics(waitBegin, frameStart, deadline, limited);
+
+  // keep the new schedule if setTargetRate() was called while waiting
+  if (limited && (generation == m_scheduleGeneration))
+  {
+    // don't try to catch up on missed frames, this would only produce a burst of short frames
+    if (frameStart - deadline > period)
+    {
+      m_statistics.numReschedules++;
+      m_deadline = frameStart + period;
+    }
+    else
+    {
+      m_deadline = deadline + period;
+    }
+  }
+}
+
+FramePacer::Statistics FramePacer::statistics() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_statistics;
+}
+
+void FramePacer::resetStatistics()
+{
+  QMutexLocker locker(&m_mutex);
+
+  m_statistics   = Statistics();
+  m_hasLastFrame = false;
+  m_frameTimeM2  = 0.0;
+  m_jitterSum    = 0.0;
+}
+
+void FramePacer::updateStatistics(const Clock::time_point& waitBegin, const Clock::time_point& frameStart,
+                                  const Clock::time_point& deadline, bool limited)
+{
+  if (limited)
+  {
+    const auto jitter = std::abs(std::chrono::duration<double>(frameStart - deadline).count());
+
+    if (waitBegin > deadline + m_overrunTolerance)
+    {
+      m_statistics.numOverruns++;
+    }
+
+    m_jitterSum += jitter;
+    m_statistics.numLimitedFrames++;
+    m_statistics.meanJitter = m_jitterSum / static_cast<double>(m_statistics.numLimitedFrames);
+    m_statistics.maxJitter  = std::max(m_statistics.maxJitter, jitter);
+  }
+
+  m_statistics.numFrames++;
+
+  if (m_hasLastFrame)
+  {
+    // Welford's online algorithm over the frame times
+    const auto frameTime  = std::chrono::duration<double>(frameStart - m_lastFrameStart).count();
+    const auto numSamples = static_cast<double>(m_statistics.numFrames - 1);
+    const auto delta      = frameTime - m_statistics.meanFrameTime;
+
+    m_statistics.lastFrameTime    = frameTime;
+    m_statistics.meanFrameTime   += delta / numSamples;
+    m_frameTimeM2                += delta * (frameTime - m_statistics.meanFrameTime);
+    m_statistics.frameTimeStdDev  = std::sqrt(m_frameTimeM2 / numSamples);
+  }
+
+  m_lastFrameStart = frameStart;
+  m_hasLastFrame   = true;
+}
+
+}
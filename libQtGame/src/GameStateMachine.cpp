@@ -0,0 +1,374 @@
+#include <libQtGame/GameStateMachine.h>
+
+#include <utilsLib/Utils.h>
+
+#include <QDataStream>
+#include <QElapsedTimer>
+
+#include <algorithm>
+
+#include "GameStatesObject.h"
+
+namespace libQtGame
+{
+static const quint32 s_snapshotMagic   = 0x51475353; // "QGSS"
+static const quint32 s_snapshotVersion = 1;
+static const int     s_streamVersion   = QDataStream::Qt_5_12;
+
+GameStateMachine::GameStateMachine(RequestDispatchMode mode, Callbacks callbacks) :
+  m_mode(mode),
+  m_callbacks(std::move(callbacks)),
+  m_simData(),
+  m_stateFactoryCache(std::make_shared<StateFactoryCache>()),
+  m_obj(std::make_unique<GameStatesObject>(*this))
+{
+  // needed for the queued connections in UiThread mode
+  qRegisterMetaType<osg::ref_ptr<AbstractGameState>>("osg::ref_ptr<AbstractGameState>");
+  qRegisterMetaType<AbstractGameState::NewGameStateMode>("NewGameStateMode");
+  qRegisterMetaType<AbstractGameState::ExitGameStateMode>("ExitGameStateMode");
+}
+
+GameStateMachine::~GameStateMachine() = default;
+
+void GameStateMachine::update(const SimulationData& data)
+{
+  QMutexLocker locker(&m_statesMutex);
+
+  m_simData = data;
+
+  if (m_mode == RequestDispatchMode::Deferred)
+  {
+    executePendingRequests();
+  }
+
+  if (m_inputEventQueue)
+  {
+    dispatchInputEvents();
+  }
+
+  if (m_states.empty() && m_callbacks.onEmptyStateList)
+  {
+    m_callbacks.onEmptyStateList();
+  }
+
+  if (m_callbacks.onPreStatesUpdate)
+  {
+    m_callbacks.onPreStatesUpdate(data);
+  }
+
+  for (auto& state : m_states)
+  {
+    if (!state.state->isExiting())
+    {
+      state.state->onUpdate(data);
+    }
+  }
+}
+
+void GameStateMachine::pushAndPrepareState(const osg::ref_ptr<AbstractGameState>& state)
+{
+  QMutexLocker locker(&m_statesMutex);
+
+  StateData data;
+  data.state = state;
+
+  m_states.push_back(data);
+  prepareGameState(data);
+}
+
+void GameStateMachine::exitState(const osg::ref_ptr<AbstractGameState>& state)
+{
+  QMutexLocker locker(&m_statesMutex);
+
+  // callers may pass a reference into m_states, which is invalidated by erase()
+  const osg::ref_ptr<AbstractGameState> exiting = state;
+
+  for (auto it = m_states.begin(); it != m_states.end(); ++it)
+  {
+    if (it->state == exiting)
+    {
+      if (m_callbacks.onExitGameState)
+      {
+        m_callbacks.onExitGameState(exiting);
+      }
+      exiting->onExit();
+
+      removePendingRequests(exiting.get());
+      m_states.erase(it);
+      return;
+    }
+  }
+
+  UTILS_LOG_FATAL("Attempting to exit unknown state");
+  assert(false);
+}
+
+void GameStateMachine::shutdown()
+{
+  QMutexLocker locker(&m_statesMutex);
+
+  for (auto& state : m_states)
+  {
+    state.state->onExit();
+  }
+
+  m_states.clear();
+  m_stateFactoryCache->clear();
+
+  std::lock_guard<std::mutex> lock(m_pendingRequestsMutex);
+  m_pendingRequests.clear();
+  m_executingRequests.clear();
+}
+
+void GameStateMachine::setInjectionMutex(const std::shared_ptr<std::recursive_mutex>& mutex)
+{
+  m_stateFactoryCache->setInjectionMutex(mutex);
+}
+
+void GameStateMachine::setInputEventQueue(const std::shared_ptr<InputEventQueue>& queue)
+{
+  QMutexLocker locker(&m_statesMutex);
+  m_inputEventQueue = queue;
+}
+
+bool GameStateMachine::isEmpty() const
+{
+  QMutexLocker locker(&m_statesMutex);
+  return m_states.empty();
+}
+
+size_t GameStateMachine::numStates() const
+{
+  QMutexLocker locker(&m_statesMutex);
+  return m_states.size();
+}
+
+QByteArray GameStateMachine::snapshotStates() const
+{
+  QMutexLocker locker(&m_statesMutex);
+
+  // states that requested to exit must not come back alive on restore
+  std::vector<osg::ref_ptr<AbstractGameState>> states;
+  for (const auto& data : m_states)
+  {
+    if (data.state->isExiting())
+    {
+      continue;
+    }
+
+    // a subclass without Q_OBJECT reports the class name of its base
+    const std::string typeName = data.state->metaObject()->className();
+    const auto        it       = m_snapshotStateFactories.find(typeName);
+    if (it == m_snapshotStateFactories.end() || it->second.type != std::type_index(typeid(*data.state)))
+    {
+      UTILS_LOG_WARN("State type " + typeName + " is not registered for snapshots");
+      return QByteArray();
+    }
+
+    states.push_back(data.state);
+  }
+
+  QByteArray  snapshot;
+  QDataStream stream(&snapshot, QIODevice::WriteOnly);
+  stream.setVersion(s_streamVersion);
+
+  stream << s_snapshotMagic << s_snapshotVersion << static_cast<quint32>(states.size());
+  for (const auto& state : states)
+  {
+    QByteArray  payload;
+    QDataStream payloadStream(&payload, QIODevice::WriteOnly);
+    payloadStream.setVersion(s_streamVersion);
+    state->serialize(payloadStream);
+
+    stream << QByteArray(state->metaObject()->className()) << payload;
+  }
+
+  return snapshot;
+}
+
+GameStateMachine::RestoreResult GameStateMachine::restoreStates(const QByteArray& snapshot)
+{
+  QMutexLocker locker(&m_statesMutex);
+
+  QElapsedTimer timer;
+  timer.start();
+
+  QDataStream stream(snapshot);
+  stream.setVersion(s_streamVersion);
+
+  quint32 magic = 0, version = 0, numStates = 0;
+  stream >> magic >> version >> numStates;
+  if (stream.status() != QDataStream::Ok || magic != s_snapshotMagic || version != s_snapshotVersion)
+  {
+    UTILS_LOG_WARN("Invalid state snapshot");
+    return {};
+  }
+
+  // create and deserialize all states up front, so an invalid snapshot leaves the current stack untouched
+  std::vector<osg::ref_ptr<AbstractGameState>> states;
+  for (quint32 i = 0; i < numStates; ++i)
+  {
+    QByteArray typeName, payload;
+    stream >> typeName >> payload;
+
+    const auto it = m_snapshotStateFactories.find(typeName.toStdString());
+    if (stream.status() != QDataStream::Ok || it == m_snapshotStateFactories.end())
+    {
+      UTILS_LOG_WARN("Unable to restore state " + typeName.toStdString());
+      return {};
+    }
+
+    const auto state = it->second.create();
+    assert_return(state.valid(), {});
+
+    QDataStream payloadStream(payload);
+    payloadStream.setVersion(s_streamVersion);
+    state->deserialize(payloadStream);
+    if (payloadStream.status() != QDataStream::Ok)
+    {
+      UTILS_LOG_WARN("Unable to deserialize state " + typeName.toStdString());
+      return {};
+    }
+
+    states.push_back(state);
+  }
+
+  while (!m_states.empty())
+  {
+    const auto state = m_states.front().state;
+    exitState(state);
+  }
+
+  for (const auto& state : states)
+  {
+    pushAndPrepareState(state);
+  }
+
+  RestoreResult result;
+  result.success   = true;
+  result.numStates = static_cast<int>(states.size());
+  result.elapsedNs = timer.nsecsElapsed();
+
+  UTILS_LOG_INFO("Restored " + std::to_string(result.numStates) + " states in " +
+    std::to_string(result.elapsedNs / 1000) + " us");
+
+  return result;
+}
+
+void GameStateMachine::prepareGameState(StateData& data)
+{
+  const auto connectionType = (m_mode == RequestDispatchMode::UiThread) ? Qt::QueuedConnection : Qt::DirectConnection;
+
+  data.state->setStateFactoryCache(m_stateFactoryCache);
+
+  if (m_mode == RequestDispatchMode::Deferred)
+  {
+    data.state->setRequestDispatcher([this, state = data.state.get()](const std::function<void()>& request)
+    {
+      std::lock_guard<std::mutex> lock(m_pendingRequestsMutex);
+      m_pendingRequests.emplace_back(state, request);
+    });
+  }
+
+  data.connections.push_back(QObject::connect(data.state.get(), &AbstractGameState::forwardNewEventStateRequest,
+    m_obj.get(), &GameStatesObject::onNewGameStateRequest, connectionType));
+  data.connections.push_back(QObject::connect(data.state.get(), &AbstractGameState::forwardExitEventStateRequest,
+    m_obj.get(), &GameStatesObject::onExitGameStateRequest, connectionType));
+
+  data.connections.push_back(QObject::connect(data.state.get(), &AbstractGameState::forwardResetTimeDeltaRequest, [this]()
+  {
+    if (m_callbacks.onResetTimeDelta)
+    {
+      m_callbacks.onResetTimeDelta();
+    }
+  }));
+
+  data.state->onInitialize(m_simData);
+  if (m_callbacks.onPrepareGameState)
+  {
+    m_callbacks.onPrepareGameState(data.state, m_simData);
+  }
+}
+
+void GameStateMachine::executePendingRequests()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_pendingRequestsMutex);
+    m_executingRequests.swap(m_pendingRequests);
+  }
+
+  // a request may exit states, which removes their remaining requests via removePendingRequests()
+  for (size_t i = 0; i < m_executingRequests.size(); ++i)
+  {
+    const auto request = m_executingRequests[i].second;
+    if (request)
+    {
+      request();
+    }
+  }
+
+  m_executingRequests.clear();
+}
+
+void GameStateMachine::removePendingRequests(AbstractGameState* state)
+{
+  for (auto& request : m_executingRequests)
+  {
+    if (request.first == state)
+    {
+      request = Request();
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(m_pendingRequestsMutex);
+  m_pendingRequests.erase(std::remove_if(m_pendingRequests.begin(), m_pendingRequests.end(),
+    [state](const Request& request) { return request.first == state; }), m_pendingRequests.end());
+}
+
+void GameStateMachine::dispatchInputEvents()
+{
+  // the top state sees each event first
+  for (const auto& event : m_inputEventQueue->acquireFrame())
+  {
+    for (auto it = m_states.rbegin(); it != m_states.rend(); ++it)
+    {
+      if (!it->state->isExiting() && it->state->onInputEvent(event))
+      {
+        break;
+      }
+    }
+  }
+}
+
+void GameStateMachine::onNewGameStateRequest(const osg::ref_ptr<AbstractGameState>& current,
+  AbstractGameState::NewGameStateMode mode, const osg::ref_ptr<AbstractGameState>& newState)
+{
+  QMutexLocker locker(&m_statesMutex);
+
+  if (mode == AbstractGameState::NewGameStateMode::ExitCurrent)
+  {
+    exitState(current);
+  }
+
+  pushAndPrepareState(newState);
+}
+
+void GameStateMachine::onExitGameStateRequest(const osg::ref_ptr<AbstractGameState>& current,
+  AbstractGameState::ExitGameStateMode mode)
+{
+  QMutexLocker locker(&m_statesMutex);
+
+  if (mode == AbstractGameState::ExitGameStateMode::ExitCurrent)
+  {
+    exitState(current);
+    return;
+  }
+
+  while (!m_states.empty())
+  {
+    const auto state = m_states.front().state;
+    exitState(state);
+  }
+}
+
+}
@@ -8,19 +8,22 @@
 #include <osgHelper/ShaderFactory.h>
 #include <osgHelper/TextureFactory.h>
 
-#include "GameStatesObject.h"
-
 namespace libQtGame
 {
 GameStatesApplication::GameStatesApplication() :
   QtUtilsApplication<osg::ref_ptr<osg::Referenced>>(),
   GameApplication(),
-  m_obj(std::make_unique<GameStatesObject>(*this))
+  m_stateMachine(GameStateMachine::RequestDispatchMode::UiThread, GameStateMachine::Callbacks{
+    [this](const osg::ref_ptr<AbstractGameState>& state, const AbstractGameState::SimulationData& simData)
+    {
+      onPrepareGameState(state, simData);
+    },
+    [this](const osg::ref_ptr<AbstractGameState>& state) { onExitGameState(state); },
+    [this]() { onEmptyStateList(); },
+    [this](const osgHelper::SimulationCallback::SimulationData& data) { onPreStatesUpdate(data); },
+    [this]() { m_updateCallback->resetTimeDelta(); }
+  })
 {
-  qRegisterMetaType<osg::ref_ptr<AbstractGameState>>("osg::ref_ptr<AbstractGameState>");
-  qRegisterMetaType<AbstractGameState::NewGameStateMode>("NewGameStateMode");
-  qRegisterMetaType<AbstractGameState::ExitGameStateMode>("ExitGameStateMode");
-
   utilsLib::ILoggingManager::getLogger()->addLoggingStrategy(
     std::make_shared<utilsLib::StdOutLoggingStrategy>());
   utilsLib::ILoggingManager::getLogger()->addLoggingStrategy(
@@ -44,12 +47,7 @@ int GameStatesApplication::runGame()
     const auto ret = execApp();
 
     // shutdown/free all pointers
-    for (auto& state : m_states)
-    {
-      state.state->onExit();
-    }
-
-    m_states.clear();
+    m_stateMachine.shutdown();
 
     onShutdown();
 
@@ -57,20 +55,14 @@ int GameStatesApplication::runGame()
   });
 }
 
-void GameStatesApplication::prepareGameState(StateData& data)
+QByteArray GameStatesApplication::snapshotStates()
 {
-  data.connections.push_back(QObject::connect(data.state.get(), &AbstractGameState::forwardNewEventStateRequest,
-    m_obj.get(), &GameStatesObject::onNewGameStateRequest, Qt::QueuedConnection));
-  data.connections.push_back(QObject::connect(data.state.get(), &AbstractGameState::forwardExitEventStateRequest,
-    m_obj.get(), &GameStatesObject::onExitGameStateRequest, Qt::QueuedConnection));
-
-  data.connections.push_back(QObject::connect(data.state.get(), &AbstractGameState::forwardResetTimeDeltaRequest, [this]()
-  {
-    m_updateCallback->resetTimeDelta();
-  }));
+  return m_stateMachine.snapshotStates();
+}
 
-  data.state->onInitialize(m_simData);
-  onPrepareGameState(data.state, m_simData);
+GameStatesApplication::RestoreResult GameStatesApplication::restoreStates(const QByteArray& snapshot)
+{
+  return m_stateMachine.restoreStates(snapshot);
 }
 
 void GameStatesApplication::onException(const std::string& message)
@@ -90,84 +82,14 @@ void GameStatesApplication::onPreStatesUpdate(const osgHelper::SimulationCallbac
 {
 }
 
-void GameStatesApplication::updateStates(const osgHelper::SimulationCallback::SimulationData& data)
-{
-  QMutexLocker locker(&m_statesMutex);
-
-  m_simData = data;
-
-  if (m_states.empty())
-  {
-    onEmptyStateList();
-  }
-
-  onPreStatesUpdate(data);
-  for (auto& state : m_states)
-  {
-    if (!state.state->isExiting())
-    {
-      state.state->onUpdate(data);
-    }
-  }
-}
-
-void GameStatesApplication::pushAndPrepareState(const osg::ref_ptr<AbstractGameState>& state)
-{
-  StateData data;
-  data.state = state;
-
-  m_states.push_back(data);
-  prepareGameState(data);
-}
-
-void GameStatesApplication::exitState(const osg::ref_ptr<AbstractGameState>& state)
+void GameStatesApplication::setInputEventQueue(const std::shared_ptr<InputEventQueue>& queue)
 {
-  for (auto it = m_states.begin(); it != m_states.end(); ++it)
-  {
-    if (it->state == state)
-    {
-      onExitGameState(state);
-      state->onExit();
-
-      m_states.erase(it);
-      return;
-    }
-  }
-
-  UTILS_LOG_FATAL("Attempting to exit unknown state");
-  assert(false);
+  m_stateMachine.setInputEventQueue(queue);
 }
 
-void GameStatesApplication::onNewGameStateRequest(const osg::ref_ptr<AbstractGameState>& current,
-  AbstractGameState::NewGameStateMode mode, const osg::ref_ptr<AbstractGameState>& newState)
-{
-  QMutexLocker locker(&m_statesMutex);
-
-  if (mode == AbstractGameState::NewGameStateMode::ExitCurrent)
-  {
-    exitState(current);
-  }
-
-  pushAndPrepareState(newState);
-}
-
-void GameStatesApplication::onExitGameStateRequest(const osg::ref_ptr<AbstractGameState>& current,
-  AbstractGameState::ExitGameStateMode mode)
+void GameStatesApplication::updateStates(const osgHelper::SimulationCallback::SimulationData& data)
 {
-  QMutexLocker locker(&m_statesMutex);
-
-  if (mode == AbstractGameState::ExitGameStateMode::ExitCurrent)
-  {
-    exitState(current);
-    return;
-  }
-
-  auto it = m_states.begin();
-  while (it != m_states.end())
-  {
-    exitState(it->state);
-    it = m_states.begin();
-  }
+  m_stateMachine.update(data);
 }
 
 }
@@ -1,13 +1,13 @@
 #include "GameStatesObject.h"
 
-#include <libQtGame/GameStatesApplication.h>
+#include <libQtGame/GameStateMachine.h>
 
 namespace libQtGame
 {
 
-GameStatesObject::GameStatesObject(GameStatesApplication& app, QObject* parent) :
+GameStatesObject::GameStatesObject(GameStateMachine& machine, QObject* parent) :
   QObject(parent),
-  m_app(app)
+  m_machine(machine)
 {
 }
 
@@ -18,14 +18,14 @@ void GameStatesObject::onNewGameStateRequest(
   AbstractGameState::NewGameStateMode mode,
   const osg::ref_ptr<AbstractGameState>& newState)
 {
-  m_app.onNewGameStateRequest(current, mode, newState);
+  m_machine.onNewGameStateRequest(current, mode, newState);
 }
 
 void GameStatesObject::onExitGameStateRequest(
   const osg::ref_ptr<AbstractGameState>& current,
   AbstractGameState::ExitGameStateMode mode)
 {
-  m_app.onExitGameStateRequest(current, mode);
+  m_machine.onExitGameStateRequest(current, mode);
 }
 
 }
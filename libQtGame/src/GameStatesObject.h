@@ -7,14 +7,14 @@
 namespace libQtGame
 {
 
-class GameStatesApplication;
+class GameStateMachine;
 
 class GameStatesObject : public QObject
 {
   Q_OBJECT
 
 public:
-  GameStatesObject(GameStatesApplication& app, QObject* parent = nullptr);
+  GameStatesObject(GameStateMachine& machine, QObject* parent = nullptr);
   ~GameStatesObject() override;
 
 public Q_SLOTS:
@@ -25,7 +25,7 @@ public Q_SLOTS:
     AbstractGameState::ExitGameStateMode mode);
 
 private:
-  GameStatesApplication& m_app;
+  GameStateMachine& m_machine;
 
 };
 
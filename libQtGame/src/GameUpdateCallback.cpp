@@ -9,6 +9,17 @@ GameUpdateCallback::GameUpdateCallback(UpdateFunc func)
 {
 }
 
+FramePacer& GameUpdateCallback::framePacer()
+{
+  return m_framePacer;
+}
+
+void GameUpdateCallback::operator()(osg::Node* node, osg::NodeVisitor* nv)
+{
+  m_framePacer.waitForNextFrame();
+  SimulationCallback::operator()(node, nv);
+}
+
 void GameUpdateCallback::action(const SimulationData& data)
 {
   m_func(data);
@@ -0,0 +1,141 @@
+#include <libQtGame/HeadlessGameStatesRunner.h>
+
+#include <QRunnable>
+
+#include <cassert>
+#include <chrono>
+
+namespace libQtGame
+{
+
+class MachineStepRunnable : public QRunnable
+{
+public:
+  explicit MachineStepRunnable(std::function<void()> func) :
+    QRunnable(),
+    m_func(std::move(func))
+  {
+    setAutoDelete(true);
+  }
+
+  void run() override
+  {
+    m_func();
+  }
+
+private:
+  std::function<void()> m_func;
+
+};
+
+HeadlessGameStatesRunner::HeadlessGameStatesRunner(int maxThreadCount) :
+  m_injectionMutex(std::make_shared<std::recursive_mutex>())
+{
+  m_threadPool.setMaxThreadCount(maxThreadCount);
+}
+
+HeadlessGameStatesRunner::~HeadlessGameStatesRunner()
+{
+  m_threadPool.waitForDone();
+}
+
+HeadlessGameStatesRunner::TimeSource HeadlessGameStatesRunner::makeFixedStepTimeSource(double stepSeconds)
+{
+  auto numSteps = std::make_shared<unsigned long long>(0);
+  return [numSteps, stepSeconds]()
+  {
+    return static_cast<double>((*numSteps)++) * stepSeconds;
+  };
+}
+
+HeadlessGameStatesRunner::TimeSource HeadlessGameStatesRunner::makeRealTimeSource()
+{
+  const auto start = std::chrono::steady_clock::now();
+  return [start]()
+  {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  };
+}
+
+GameStateMachine& HeadlessGameStatesRunner::addMachine(TimeSource timeSource, GameStateMachine::Callbacks callbacks)
+{
+  auto data = std::make_unique<MachineData>();
+  data->timeSource = std::move(timeSource);
+
+  auto& resetTimeDelta = data->resetTimeDelta;
+  auto  onResetTimeDelta = std::move(callbacks.onResetTimeDelta);
+  callbacks.onResetTimeDelta = [&resetTimeDelta, onResetTimeDelta]()
+  {
+    resetTimeDelta = true;
+    if (onResetTimeDelta)
+    {
+      onResetTimeDelta();
+    }
+  };
+
+  data->machine = std::make_unique<GameStateMachine>(
+    GameStateMachine::RequestDispatchMode::Deferred, std::move(callbacks));
+  data->machine->setInjectionMutex(m_injectionMutex);
+
+  m_machines.push_back(std::move(data));
+  return *m_machines.back()->machine;
+}
+
+size_t HeadlessGameStatesRunner::numMachines() const
+{
+  return m_machines.size();
+}
+
+GameStateMachine& HeadlessGameStatesRunner::machine(size_t index)
+{
+  assert(index < m_machines.size());
+  return *m_machines[index]->machine;
+}
+
+void HeadlessGameStatesRunner::step()
+{
+  for (auto& data : m_machines)
+  {
+    auto* machineData = data.get();
+    m_threadPool.start(new MachineStepRunnable([machineData]()
+    {
+      stepMachine(*machineData);
+    }));
+  }
+
+  m_threadPool.waitForDone();
+}
+
+void HeadlessGameStatesRunner::run(int numSteps)
+{
+  for (auto i = 0; i < numSteps; ++i)
+  {
+    step();
+  }
+}
+
+void HeadlessGameStatesRunner::shutdown()
+{
+  m_threadPool.waitForDone();
+  for (auto& data : m_machines)
+  {
+    data->machine->shutdown();
+  }
+}
+
+void HeadlessGameStatesRunner::stepMachine(MachineData& data)
+{
+  const auto time  = data.timeSource();
+  const auto reset = data.resetTimeDelta.exchange(false);
+
+  GameStateMachine::SimulationData simData;
+  simData.time      = time;
+  simData.timeDelta = (data.hasLastTime && !reset) ? (time - data.lastTime) : 0.0;
+
+  data.lastTime    = time;
+  data.hasLastTime = true;
+
+  data.machine->update(simData);
+}
+
+}
@@ -0,0 +1,51 @@
+#include <libQtGame/InputEventQueue.h>
+
+namespace libQtGame
+{
+
+InputEventQueue::InputEventQueue(size_t capacity) :
+  m_capacity(capacity),
+  m_numDropped(0)
+{
+  m_pending.reserve(capacity);
+  m_frame.reserve(capacity);
+}
+
+InputEventQueue::~InputEventQueue() = default;
+
+bool InputEventQueue::push(const InputEvent& event)
+{
+  QMutexLocker locker(&m_mutex);
+
+  if (m_pending.size() >= m_capacity)
+  {
+    ++m_numDropped;
+    return false;
+  }
+
+  m_pending.push_back(event);
+  return true;
+}
+
+const std::vector<InputEvent>& InputEventQueue::acquireFrame()
+{
+  m_frame.clear();
+
+  QMutexLocker locker(&m_mutex);
+  m_frame.swap(m_pending);
+
+  return m_frame;
+}
+
+size_t InputEventQueue::capacity() const
+{
+  return m_capacity;
+}
+
+size_t InputEventQueue::numDropped() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_numDropped;
+}
+
+}
@@ -2,6 +2,7 @@
 
 #include <QMouseEvent>
 #include <QCursor>
+#include <QWindow>
 
 #include <utilsLib/Utils.h>
 
@@ -10,7 +11,9 @@ namespace libQtGame
 
 KeyboardMouseEventFilter::KeyboardMouseEventFilter(QObject* parent) :
   QObject(parent),
-  m_isMouseCaptured(false)
+  m_isMouseCaptured(false),
+  m_mouseCaptureMode(MouseCaptureMode::Warp),
+  m_relativeCaptureMargin(32)
 {
 }
 
@@ -44,17 +47,32 @@ bool KeyboardMouseEventFilter::isMouseDragging(const std::optional<Qt::MouseButt
   return m_mouseDragData && m_mouseDragData->moved && (!button || (*button == m_mouseDragData->button));
 }
 
-void KeyboardMouseEventFilter::setCaptureMouse(bool on)
+void KeyboardMouseEventFilter::setCaptureMouse(bool on, MouseCaptureMode mode)
 {
   QMutexLocker locker(&m_mutex);
 
+  m_mouseCaptureMode = mode;
   if (m_isMouseCaptured == on)
   {
     return;
   }
 
-  m_isMouseCaptured  = on;
-  m_capturedMousePos = QCursor::pos();
+  m_isMouseCaptured    = on;
+  m_capturedMousePos   = QCursor::pos();
+  m_lastGlobalMousePos = m_capturedMousePos;
+  m_recenterMousePos.reset();
+}
+
+void KeyboardMouseEventFilter::setRelativeCaptureMargin(int margin)
+{
+  QMutexLocker locker(&m_mutex);
+  m_relativeCaptureMargin = margin;
+}
+
+void KeyboardMouseEventFilter::setInputEventQueue(const std::shared_ptr<InputEventQueue>& queue)
+{
+  QMutexLocker locker(&m_mutex);
+  m_inputEventQueue = queue;
 }
 
 bool KeyboardMouseEventFilter::eventFilter(QObject* object, QEvent* event)
@@ -80,6 +98,13 @@ bool KeyboardMouseEventFilter::eventFilter(QObject* object, QEvent* event)
     }
     setKeyDown(static_cast<Qt::Key>(keyEvent->key()), event->type() == QEvent::Type::KeyPress);
 
+    if (const auto queue = inputEventQueue())
+    {
+      const auto type = (event->type() == QEvent::Type::KeyPress) ? InputEvent::Type::KeyPress : InputEvent::Type::KeyRelease;
+      queue->push(InputEvent{ type, keyEvent->modifiers(), keyEvent->key(), 0, 0, osg::Vec2f() });
+      return false;
+    }
+
     auto accepted = false;
     Q_EMIT triggerKeyEvent(keyEvent, accepted);
     return accepted;
@@ -92,7 +117,7 @@ bool KeyboardMouseEventFilter::eventFilter(QObject* object, QEvent* event)
     const auto mouseEvent = dynamic_cast<QMouseEvent*>(event);
     assert_return(mouseEvent, false);
 
-    return handleMouseEvent(mouseEvent);
+    return handleMouseEvent(object, mouseEvent);
   }
   case QEvent::Type::HoverMove:
   {
@@ -102,13 +127,22 @@ bool KeyboardMouseEventFilter::eventFilter(QObject* object, QEvent* event)
     QMouseEvent mouseEvent(QEvent::MouseMove, hoverEvent->pos(),
       Qt::MouseButton::NoButton, Qt::MouseButton::NoButton, Qt::KeyboardModifier::NoModifier);
 
-    return handleMouseEvent(&mouseEvent);
+    return handleMouseEvent(object, &mouseEvent);
   }
   case QEvent::Type::Wheel:
   {
     const auto wheelEvent = dynamic_cast<QWheelEvent*>(event);
     assert_return(wheelEvent, false);
 
+    if (const auto queue = inputEventQueue())
+    {
+      const auto delta = wheelEvent->angleDelta();
+      const auto pos   = wheelEvent->position();
+      queue->push(InputEvent{ InputEvent::Type::Wheel, wheelEvent->modifiers(), 0, delta.x(), delta.y(),
+        osg::Vec2f(static_cast<float>(pos.x()), static_cast<float>(pos.y())) });
+      return false;
+    }
+
     auto accepted = false;
     Q_EMIT triggerWheelEvent(wheelEvent, accepted);
     return accepted;
@@ -132,8 +166,19 @@ void KeyboardMouseEventFilter::setKeyDown(Qt::Key key, bool down)
   m_isKeyDown[key] = down;
 }
 
-bool KeyboardMouseEventFilter::handleMouseEvent(QMouseEvent* mouseEvent)
+std::shared_ptr<InputEventQueue> KeyboardMouseEventFilter::inputEventQueue() const
 {
+  QMutexLocker locker(&m_mutex);
+  return m_inputEventQueue;
+}
+
+bool KeyboardMouseEventFilter::handleMouseEvent(QObject* object, QMouseEvent* mouseEvent)
+{
+  if (isRecenterMouseMove(mouseEvent))
+  {
+    return true;
+  }
+
   switch (mouseEvent->type())
   {
   case QEvent::Type::MouseButtonPress:
@@ -169,7 +214,7 @@ bool KeyboardMouseEventFilter::handleMouseEvent(QMouseEvent* mouseEvent)
     break;
   }
 
-  handleMouseCapture(mouseEvent);
+  handleMouseCapture(object, mouseEvent);
 
   auto accepted = false;
   Q_EMIT triggerMouseEvent(mouseEvent, accepted);
@@ -199,13 +244,65 @@ std::optional<KeyboardMouseEventFilter::MouseDragData> KeyboardMouseEventFilter:
   return std::nullopt;
 }
 
-void KeyboardMouseEventFilter::handleMouseCapture(QMouseEvent* mouseEvent)
+bool KeyboardMouseEventFilter::isRecenterMouseMove(QMouseEvent* mouseEvent)
+{
+  QMutexLocker locker(&m_mutex);
+  if (mouseEvent->type() != QEvent::Type::MouseMove || !m_recenterMousePos)
+  {
+    return false;
+  }
+
+  // moves queued before the synthetic one still carry pre-warp positions and are processed normally
+  if (mouseEvent->globalPos() != *m_recenterMousePos)
+  {
+    return false;
+  }
+
+  // synthetic move caused by QCursor::setPos(), deltas continue from the center
+  m_lastGlobalMousePos = *m_recenterMousePos;
+  m_recenterMousePos.reset();
+  return true;
+}
+
+void KeyboardMouseEventFilter::handleMouseCapture(QObject* object, QMouseEvent* mouseEvent)
 {
   QMutexLocker locker(&m_mutex);
-  if (mouseEvent->type() == QEvent::Type::MouseMove && m_isMouseCaptured)
+  if (mouseEvent->type() != QEvent::Type::MouseMove || !m_isMouseCaptured)
+  {
+    return;
+  }
+
+  if (m_mouseCaptureMode == MouseCaptureMode::Warp)
   {
     QCursor::setPos(m_capturedMousePos);
+    return;
+  }
+
+  m_lastGlobalMousePos = mouseEvent->globalPos();
+
+  // wait for the synthetic move of a pending re-center
+  if (m_recenterMousePos)
+  {
+    return;
   }
+
+  const auto window = qobject_cast<QWindow*>(object);
+  const auto size   = window ? window->size() : object->property("size").toSize();
+  const auto pos    = mouseEvent->pos();
+
+  if (size.isValid() &&
+      pos.x() >= m_relativeCaptureMargin && pos.x() < size.width() - m_relativeCaptureMargin &&
+      pos.y() >= m_relativeCaptureMargin && pos.y() < size.height() - m_relativeCaptureMargin)
+  {
+    return;
+  }
+
+  const auto center = size.isValid()
+    ? mouseEvent->globalPos() - pos + QPoint(size.width() / 2, size.height() / 2)
+    : m_capturedMousePos;
+
+  m_recenterMousePos = center;
+  QCursor::setPos(center);
 }
 
 KeyboardMouseEventFilter::MouseDragMoveData KeyboardMouseEventFilter::handleMouseDragMove(QMouseEvent* mouseEvent)
@@ -224,7 +321,12 @@ KeyboardMouseEventFilter::MouseDragMoveData KeyboardMouseEventFilter::handleMous
     m_mouseDragData->moved = true;
   }
 
-  if (m_isMouseCaptured)
+  if (m_isMouseCaptured && (m_mouseCaptureMode == MouseCaptureMode::Relative))
+  {
+    const auto delta = m_lastGlobalMousePos - mouseEvent->globalPos();
+    data.change = osg::Vec2f(static_cast<float>(delta.x()), static_cast<float>(delta.y()));
+  }
+  else if (m_isMouseCaptured)
   {
     const auto delta = m_capturedMousePos - mouseEvent->globalPos();
     data.change = osg::Vec2f(static_cast<int>(delta.x()), static_cast<int>(delta.y()));
@@ -0,0 +1,26 @@
+#include <libQtGame/StateFactory.h>
+
+namespace libQtGame
+{
+
+StateFactoryCache::StateFactoryCache() = default;
+
+StateFactoryCache::~StateFactoryCache() = default;
+
+void StateFactoryCache::clear()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_entries.clear();
+}
+
+void StateFactoryCache::setInjectionMutex(const std::shared_ptr<std::recursive_mutex>& mutex)
+{
+  m_injectionMutex = mutex;
+}
+
+std::recursive_mutex* StateFactoryCache::injectionMutex() const
+{
+  return m_injectionMutex.get();
+}
+
+}
@@ -0,0 +1,343 @@
+#include <libQtGame/KeyboardMouseEventFilter.h>
+
+#include <QGuiApplication>
+#include <QHoverEvent>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QThread>
+#include <QWheelEvent>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * Benchmarks KeyboardMouseEventFilter with the UI thread flooding events into eventFilter()
+ * while 0..N reader threads query isKeyDown(), isMouseButtonDown() and isMouseDragging().
+ *
+ * Usage: libQtGameBenchmark [seconds per run = 1.0] [max reader threads = ideal thread count]
+ * Runs offscreen unless QT_QPA_PLATFORM is set otherwise.
+ */
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Fixed size log-bucket latency histogram: 8 linear sub-buckets per power of two (~12% resolution)
+ */
+class LatencyHistogram
+{
+public:
+  void record(long long ns)
+  {
+    const auto value = static_cast<unsigned long long>(std::max(1ll, ns));
+    m_buckets[std::min(bucketIndex(value), s_numBuckets - 1)]++;
+    m_count++;
+    m_max = std::max(m_max, ns);
+  }
+
+  void merge(const LatencyHistogram& other)
+  {
+    for (size_t i = 0; i < s_numBuckets; ++i)
+    {
+      m_buckets[i] += other.m_buckets[i];
+    }
+    m_count += other.m_count;
+    m_max = std::max(m_max, other.m_max);
+  }
+
+  unsigned long long count() const
+  {
+    return m_count;
+  }
+
+  long long max() const
+  {
+    return m_max;
+  }
+
+  // Upper bound of the bucket containing the given percentile
+  long long percentile(double p) const
+  {
+    if (m_count == 0)
+    {
+      return 0;
+    }
+
+    const auto rank = static_cast<unsigned long long>(p * static_cast<double>(m_count - 1)) + 1;
+    auto sum = 0ull;
+    for (size_t i = 0; i < s_numBuckets; ++i)
+    {
+      sum += m_buckets[i];
+      if (sum >= rank)
+      {
+        return std::min(bucketUpperBound(i), m_max);
+      }
+    }
+    return m_max;
+  }
+
+  // Fraction of samples in buckets above the one containing the threshold
+  double fractionAbove(long long thresholdNs) const
+  {
+    if (m_count == 0)
+    {
+      return 0.0;
+    }
+
+    const auto first = bucketIndex(static_cast<unsigned long long>(std::max(1ll, thresholdNs))) + 1;
+    auto sum = 0ull;
+    for (auto i = first; i < s_numBuckets; ++i)
+    {
+      sum += m_buckets[i];
+    }
+    return static_cast<double>(sum) / static_cast<double>(m_count);
+  }
+
+private:
+  static constexpr size_t s_subBucketBits = 3;
+  static constexpr size_t s_numSubBuckets = 1 << s_subBucketBits;
+  static constexpr size_t s_numBuckets    = 48 * s_numSubBuckets;
+
+  std::array<unsigned long long, s_numBuckets> m_buckets {};
+  unsigned long long m_count = 0;
+  long long m_max = 0;
+
+  static size_t bucketIndex(unsigned long long value)
+  {
+    if (value < s_numSubBuckets)
+    {
+      return static_cast<size_t>(value);
+    }
+
+    size_t exponent = 0;
+    while ((value >> exponent) >= (2 * s_numSubBuckets))
+    {
+      exponent++;
+    }
+    const auto subBucket = static_cast<size_t>(value >> exponent) - s_numSubBuckets;
+    return (exponent + 1) * s_numSubBuckets + subBucket;
+  }
+
+  static long long bucketUpperBound(size_t index)
+  {
+    if (index < s_numSubBuckets)
+    {
+      return static_cast<long long>(index);
+    }
+
+    const auto exponent  = index / s_numSubBuckets - 1;
+    const auto subBucket = index % s_numSubBuckets;
+    return static_cast<long long>(((s_numSubBuckets + subBucket + 1) << exponent) - 1);
+  }
+
+};
+
+struct RunResult
+{
+  unsigned long long numEvents = 0;
+  double seconds = 0.0;
+  LatencyHistogram queryLatencies;
+};
+
+class EventFlood
+{
+public:
+  EventFlood()
+  {
+    const QPointF pos(100.0, 100.0);
+
+    for (const auto key : { Qt::Key_W, Qt::Key_A, Qt::Key_S, Qt::Key_D })
+    {
+      m_events.push_back(std::make_unique<QKeyEvent>(QEvent::KeyPress, key, Qt::NoModifier));
+      m_events.push_back(std::make_unique<QKeyEvent>(QEvent::KeyRelease, key, Qt::NoModifier));
+    }
+
+    m_events.push_back(std::make_unique<QMouseEvent>(QEvent::MouseButtonPress, pos,
+      Qt::LeftButton, Qt::LeftButton, Qt::NoModifier));
+    for (auto i = 1; i <= 8; ++i)
+    {
+      m_events.push_back(std::make_unique<QMouseEvent>(QEvent::MouseMove, pos + QPointF(i, i),
+        Qt::NoButton, Qt::LeftButton, Qt::NoModifier));
+    }
+    m_events.push_back(std::make_unique<QMouseEvent>(QEvent::MouseButtonRelease, pos + QPointF(8, 8),
+      Qt::LeftButton, Qt::NoButton, Qt::NoModifier));
+
+    for (auto i = 1; i <= 4; ++i)
+    {
+      m_events.push_back(std::make_unique<QHoverEvent>(QEvent::HoverMove, pos + QPointF(i, 0), pos));
+    }
+
+    m_events.push_back(std::make_unique<QWheelEvent>(pos, pos, QPoint(), QPoint(0, 120),
+      Qt::NoButton, Qt::NoModifier, Qt::NoScrollPhase, false));
+  }
+
+  QEvent* next()
+  {
+    auto* event = m_events[m_index].get();
+    m_index = (m_index + 1) % m_events.size();
+    return event;
+  }
+
+private:
+  std::vector<std::unique_ptr<QEvent>> m_events;
+  size_t m_index = 0;
+
+};
+
+static RunResult runBenchmark(QObject& target, const libQtGame::KeyboardMouseEventFilter& filter, int numReaders, bool flood, double seconds)
+{
+  std::atomic<bool> running { true };
+  std::atomic<int>  numReady { 0 };
+
+  std::vector<LatencyHistogram> latencies(numReaders);
+  std::vector<std::thread> readers;
+  for (auto i = 0; i < numReaders; ++i)
+  {
+    readers.emplace_back([&, i]()
+    {
+      LatencyHistogram histogram;
+
+      ++numReady;
+      auto query = 0u;
+      while (running.load(std::memory_order_relaxed))
+      {
+        const auto start = Clock::now();
+        switch (query++ % 3)
+        {
+        case 0:
+          filter.isKeyDown(Qt::Key_W);
+          break;
+        case 1:
+          filter.isMouseButtonDown(Qt::LeftButton);
+          break;
+        default:
+          filter.isMouseDragging();
+          break;
+        }
+        histogram.record(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+      }
+
+      latencies[i] = histogram;
+    });
+  }
+
+  while (numReady < numReaders)
+  {
+    std::this_thread::yield();
+  }
+
+  RunResult result;
+  EventFlood events;
+
+  const auto start    = Clock::now();
+  const auto deadline = start + std::chrono::duration<double>(seconds);
+  while (Clock::now() < deadline)
+  {
+    if (!flood)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      continue;
+    }
+
+    for (auto i = 0; i < 64; ++i)
+    {
+      QCoreApplication::sendEvent(&target, events.next());
+    }
+    result.numEvents += 64;
+  }
+
+  result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  running = false;
+
+  for (auto& reader : readers)
+  {
+    reader.join();
+  }
+
+  for (const auto& histogram : latencies)
+  {
+    result.queryLatencies.merge(histogram);
+  }
+
+  return result;
+}
+
+static double queriesPerSecond(const RunResult& result)
+{
+  return static_cast<double>(result.queryLatencies.count()) / result.seconds;
+}
+
+int main(int argc, char** argv)
+{
+  if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+  {
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  }
+
+  QGuiApplication app(argc, argv);
+
+  const auto seconds    = (argc > 1) ? std::atof(argv[1]) : 1.0;
+  const auto maxReaders = (argc > 2) ? std::atoi(argv[2]) : std::max(1, QThread::idealThreadCount());
+
+  QObject target;
+  auto*   filter = new libQtGame::KeyboardMouseEventFilter(&target);
+  target.installEventFilter(filter);
+
+  struct Row
+  {
+    int numReaders;
+    double eventsPerSecond;
+    double queriesPerSecond;
+    long long p50, p90, p99, p999, max;
+    double p99Ratio;
+    double slowFraction;
+  };
+  std::vector<Row> rows;
+
+  std::printf("%-8s %14s %14s %10s %10s %10s %10s %10s %10s %8s\n",
+    "readers", "events/s", "queries/s", "p50 ns", "p90 ns", "p99 ns", "p99.9 ns", "max ns", "p99 ratio", "slow %");
+
+  for (auto numReaders = 0; numReaders <= maxReaders; numReaders = (numReaders == 0) ? 1 : numReaders * 2)
+  {
+    const auto  contended = runBenchmark(target, *filter, numReaders, true, seconds);
+    const auto& latencies = contended.queryLatencies;
+
+    Row row { numReaders, static_cast<double>(contended.numEvents) / contended.seconds, queriesPerSecond(contended),
+      latencies.percentile(0.5), latencies.percentile(0.9), latencies.percentile(0.99), latencies.percentile(0.999),
+      latencies.max(), 0.0, 0.0 };
+
+    // Lock contention shows in the tail: it is reported as the p99 slowdown against the same readers without
+    // event flood, and as the fraction of queries slower than the uncontended p99
+    if (numReaders > 0)
+    {
+      const auto uncontended = runBenchmark(target, *filter, numReaders, false, seconds);
+      const auto baseline    = uncontended.queryLatencies.percentile(0.99);
+
+      row.p99Ratio     = (baseline > 0) ? static_cast<double>(row.p99) / static_cast<double>(baseline) : 0.0;
+      row.slowFraction = latencies.fractionAbove(baseline);
+    }
+
+    std::printf("%-8d %14.0f %14.0f %10lld %10lld %10lld %10lld %10lld %9.2fx %7.2f%%\n",
+      row.numReaders, row.eventsPerSecond, row.queriesPerSecond, row.p50, row.p90, row.p99, row.p999, row.max,
+      row.p99Ratio, row.slowFraction * 100.0);
+
+    rows.push_back(row);
+  }
+
+  // Machine-readable output for tracking per commit, filter with grep '^csv,'
+  std::printf("\ncsv,readers,events_per_s,queries_per_s,p50_ns,p90_ns,p99_ns,p999_ns,max_ns,p99_ratio,slow_fraction\n");
+  for (const auto& row : rows)
+  {
+    std::printf("csv,%d,%.0f,%.0f,%lld,%lld,%lld,%lld,%lld,%.4f,%.6f\n",
+      row.numReaders, row.eventsPerSecond, row.queriesPerSecond, row.p50, row.p90, row.p99, row.p999, row.max,
+      row.p99Ratio, row.slowFraction);
+  }
+
+  return 0;
+}